@@ -0,0 +1,80 @@
+#define _POSIX_C_SOURCE 200809L // for fork, kill and clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "spectator.h"
+
+//measures what publishing to the spectator feed costs the game
+//publishes a full 10x10 board over and over, first with no viewers and then with
+//viewer processes reading the feed as fast as they can
+//usage: ./bench_feed [publishes] [viewers]
+
+#define BENCH_N 10
+
+double timePublishes(SpectatorFeed* feed, char** board, long count);
+
+int main(int argc, char* argv[]) {
+    long count = (argc > 1) ? atol(argv[1]) : 10000000L;
+    int viewers = (argc > 2) ? atoi(argv[2]) : 4;
+    if (count < 1 || viewers < 0) {
+        printf("Usage: %s [publishes] [viewers]\n", argv[0]);
+        return 1;
+    }
+
+    char rows[BENCH_N][BENCH_N];
+    char* board[BENCH_N];
+    for (int i = 0; i < BENCH_N; i++) {
+        board[i] = rows[i];
+        for (int j = 0; j < BENCH_N; j++) rows[i][j] = ((i + j) % 3 == 0) ? 'X' : ((i + j) % 3 == 1) ? 'O' : ' ';
+    }
+
+    char name[FEED_NAME_MAX];
+    snprintf(name, sizeof(name), FEED_PREFIX "bench_%d", (int) getpid());
+    SpectatorFeed* feed = openFeed(name);
+    if (!feed) {
+        printf("Failed to create feed %s!\n", name);
+        return 1;
+    }
+
+    printf("no feed:            %6.1f ns per move\n", timePublishes(NULL, board, count));
+    printf("feed, 0 viewers:    %6.1f ns per move\n", timePublishes(feed, board, count));
+
+    //viewers that never sleep, far busier than viewer.c, to show the worst case
+    pid_t children[64];
+    if (viewers > 64) viewers = 64;
+    for (int v = 0; v < viewers; v++) {
+        children[v] = fork();
+        if (children[v] == 0) {
+            const SpectatorFeed* reader = attachFeed(name);
+            SpectatorFeed copy;
+            while (reader) readFeed(reader, &copy);
+            _exit(0);
+        }
+    }
+    sleep(1);// let them attach
+    printf("feed, %2d viewers:   %6.1f ns per move\n", viewers, timePublishes(feed, board, count));
+
+    for (int v = 0; v < viewers; v++) {
+        if (children[v] > 0) {
+            kill(children[v], SIGTERM);
+            waitpid(children[v], NULL, 0);
+        }
+    }
+    closeFeed(feed, name);
+    return 0;
+}
+
+//average time of one publishFeed call (a NULL feed measures just the loop and call)
+double timePublishes(SpectatorFeed* feed, char** board, long count) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < count; i++) {
+        publishFeed(feed, board, BENCH_N, 'X', (int) (i % 100), 0, 0, FEED_PLAYING, ' ');
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    return ns / count;
+}
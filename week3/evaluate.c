@@ -0,0 +1,112 @@
+#include "evaluate.h"
+
+//positions are handled in blocks so the per-line counters stay in cache
+//inner loops run over positions, so the compiler can vectorise them
+#define BLOCK 256
+#define MAX_LINES (2 * 10 + 2) //rows, columns and two diagonals on the biggest board
+#define MAX_LINE_CELLS 10
+
+int buildLines(int N, int lines[MAX_LINES][MAX_LINE_CELLS]);
+void evaluateBlock(const PositionBatch* batch, BatchFeatures* out, int start, int end,
+                   int lines[MAX_LINES][MAX_LINE_CELLS], int numLines);
+
+void evaluateBatch(const PositionBatch* batch, BatchFeatures* out) {
+    int lines[MAX_LINES][MAX_LINE_CELLS];
+    int numLines = buildLines(batch->N, lines);
+    if (numLines == 0) return;// unsupported board size
+    if (batch->numPlayers != 2 && batch->numPlayers != 3) return;
+
+    int numBlocks = (batch->count + BLOCK - 1) / BLOCK;
+    //blocks write to separate parts of the output, so they can run on different threads
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(static)
+#endif
+    for (int b = 0; b < numBlocks; b++) {
+        int start = b * BLOCK;
+        int end = (start + BLOCK < batch->count) ? start + BLOCK : batch->count;
+        evaluateBlock(batch, out, start, end, lines, numLines);
+    }
+}
+
+//lists the cells of every row, column and both diagonals, returns how many lines there are
+int buildLines(int N, int lines[MAX_LINES][MAX_LINE_CELLS]) {
+    if (N < 1 || N > MAX_LINE_CELLS) return 0;
+    int n = 0;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            lines[n][j] = i * N + j;// row i
+            lines[n + 1][j] = j * N + i;// column i
+        }
+        n += 2;
+    }
+    for (int i = 0; i < N; i++) {
+        lines[n][i] = i * N + i;// main diagonal
+        lines[n + 1][i] = i * N + (N - i - 1);// anti-diagonal
+    }
+    return n + 2;
+}
+
+void evaluateBlock(const PositionBatch* batch, BatchFeatures* out, int start, int end,
+                   int lines[MAX_LINES][MAX_LINE_CELLS], int numLines) {
+    int N = batch->N;
+    int numPlayers = batch->numPlayers;
+    int size = end - start;
+    const unsigned char* toMove = batch->toMove + start;
+
+    //counts for the line being checked, one entry per position in the block
+    unsigned char mine[BLOCK], empty[BLOCK], next1[BLOCK], next2[BLOCK];
+    unsigned char win[BLOCK], block[BLOCK], open[BLOCK], oppOpen[BLOCK];
+    //the opponents in turn order, firstOpp moves next; with 2 players secondOpp is 255, which no cell holds
+    unsigned char firstOpp[BLOCK], secondOpp[BLOCK];
+    //cells where the next player could complete a line, for the 2-ply search:
+    //the first one found (255 = none yet) and whether a different second one exists
+    unsigned char emptyAt[BLOCK], threatCell[BLOCK], twoThreats[BLOCK];
+
+    for (int p = 0; p < size; p++) {
+        win[p] = block[p] = open[p] = oppOpen[p] = twoThreats[p] = 0;
+        threatCell[p] = 255;
+        firstOpp[p] = (unsigned char) (toMove[p] % numPlayers + 1);
+        secondOpp[p] = (numPlayers == 3) ? (unsigned char) ((toMove[p] + 1) % 3 + 1) : 255;
+    }
+
+    for (int l = 0; l < numLines; l++) {
+        for (int p = 0; p < size; p++) mine[p] = empty[p] = next1[p] = next2[p] = emptyAt[p] = 0;
+        for (int k = 0; k < N; k++) {
+            unsigned char cell = (unsigned char) lines[l][k];
+            const unsigned char* column = batch->cells + (long) cell * batch->stride + start;
+            for (int p = 0; p < size; p++) {
+                unsigned char v = column[p];
+                mine[p] += (v == toMove[p]);
+                empty[p] += (v == 0);
+                emptyAt[p] += (v == 0) * cell;// only used when the line has exactly one empty cell
+                next1[p] += (v == firstOpp[p]);
+                next2[p] += (v == secondOpp[p]);
+            }
+        }
+        for (int p = 0; p < size; p++) {
+            int oneLeft = (empty[p] == 1);
+            win[p] += oneLeft & (mine[p] == N - 1);
+            block[p] += oneLeft & ((next1[p] == N - 1) | (next2[p] == N - 1));
+            open[p] += (mine[p] + empty[p] == N);
+            oppOpen[p] += (next1[p] + empty[p] == N) | (next2[p] + empty[p] == N);
+            int threat = oneLeft & (next1[p] == N - 1);
+            twoThreats[p] |= threat & (threatCell[p] != 255) & (threatCell[p] != emptyAt[p]);
+            threatCell[p] = (threat & (threatCell[p] == 255)) ? emptyAt[p] : threatCell[p];
+        }
+    }
+
+    float scale = 0.5f / (float) numLines;
+    for (int p = 0; p < size; p++) {
+        out->winLines[start + p] = win[p];
+        out->blockLines[start + p] = block[p];
+        out->openLines[start + p] = open[p];
+        out->oppOpenLines[start + p] = oppOpen[p];
+        //2-ply search in the computer's order: a winning move first, otherwise the next player
+        //wins unless one move can block every cell that completes one of their lines
+        //positions the search can't decide are ranked by the open line difference
+        float value = ((int) open[p] - (int) oppOpen[p]) * scale;
+        if (twoThreats[p]) value = -1.0f;
+        if (win[p] > 0) value = 1.0f;
+        out->value[start + p] = value;
+    }
+}
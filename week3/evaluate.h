@@ -0,0 +1,36 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+//batch position evaluation
+//works on thousands of positions at once instead of one char** board at a time
+//built into multiuser by the Makefile, with -fopenmp so blocks of positions run on every core
+
+//positions are stored column by column (structure of arrays):
+//cell c of position p is cells[c * stride + p], cells are numbered row by row (c = row * N + col)
+//cell values: 0 = empty, 1 = X, 2 = O, 3 = Z
+//toMove[p] is the player (1-3) whose turn it is in position p, play goes 1, 2(, 3), 1, ...
+typedef struct {
+    int N;
+    int numPlayers;// 2 (X and O) or 3 (X, O and Z), the same for every position
+    int count;// number of positions
+    int stride;// distance between two columns, at least count
+    const unsigned char* cells;// N*N columns
+    const unsigned char* toMove;
+} PositionBatch;
+
+//one output column per feature, each with room for count entries
+//all features are from the point of view of the player to move
+typedef struct {
+    unsigned char* winLines;// lines the player can finish this move
+    unsigned char* blockLines;// lines an opponent can finish next move (each has to be blocked)
+    unsigned char* openLines;// lines that only contain the player's marks and empty cells
+    unsigned char* oppOpenLines;// same for any single opponent
+    float* value;// result of a 2-ply search (player to move, then the next player):
+                 // 1 = winning move available, -1 = the next player (toMove % numPlayers + 1) has two or more
+                 // winning cells, so one move can't block them all,
+                 // otherwise undecided and ranked by the open line difference in (-0.5, 0.5)
+} BatchFeatures;
+
+void evaluateBatch(const PositionBatch* batch, BatchFeatures* out);
+
+#endif
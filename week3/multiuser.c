@@ -1,10 +1,41 @@
+#define _POSIX_C_SOURCE 200809L // for fsync and fileno
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "spectator.h"
+#include "evaluate.h"
 
 #define MIN_SIZE 3
 #define MAX_SIZE 10
 
+#define SCRIPT_SEED 1 //default seed for --script, so replays give the same result every run
+
+#define SAVE_FILE "tic_tac_toe_save.bin"
+#define SAVE_EVERY 1 //write a snapshot after every this many moves
+#define SNAPSHOT_VERSION 1
+#define MAX_SNAPSHOT (24 + 3 * MAX_SIZE * MAX_SIZE) //header + board + two bytes per move
+
+#define EXPORT_VERSION 2
+#define EXPORT_HEADER 64 //bytes before the first chunk and before each chunk's columns
+#define EXPORT_CHUNK 4096 //positions per chunk, a multiple of 64 keeps every column aligned
+
+//everything needed to continue a game except the board itself
+typedef struct {
+    int N;
+    int mode;
+    int numPlayers;
+    char activePlayers[3];
+    int playerRoles[3];// 1 = human, 2 = computer
+    int currentIndex;
+    int moveCount;
+    unsigned char moveRows[MAX_SIZE * MAX_SIZE];// move history, 0-indexed
+    unsigned char moveCols[MAX_SIZE * MAX_SIZE];
+    unsigned int rngState;// the computer's random number generator, never 0
+} GameState;
+
 //board operations
 //functions to create, display and free the tic-tac-toe board
 char** createBoard(int N);
@@ -13,8 +44,10 @@ void freeBoard(char** board, int N);
 
 //player moves
 //functions for taking player input and computer moves
-int playerMove(char** board, int N, char player);
-void computerMove(char** board, int N, char player, char players[], int numPlayers);
+//both report the cell they filled through row and col
+//the computer draws its random moves from rng, so every game keeps its own generator
+int playerMove(char** board, int N, char player, int* row, int* col);
+void computerMove(char** board, int N, char player, char players[], int numPlayers, unsigned int* rng, int* row, int* col);
 int willWin(char** board, int N, char player, int row, int col);
 
 //game state checking
@@ -26,27 +59,190 @@ int isSuddenDraw(char** board, int N);
 //this function will take the current state of the game board and write it to a log file
 void logMove(FILE* file, char** board, int N, char player);
 
-int main() {
-    int N, mode;
-    //choosing game mode
-    printf("Choose game mode:\n1. User vs User\n2. User vs Computer\n3. Multi-Player Mode (X, O, Z)\nEnter choice (1/2/3): ");
-    while (scanf("%d", &mode) != 1 || mode < 1 || mode > 3) {
-        printf("Invalid choice. Enter 1, 2, or 3: ");
-        while(getchar() != '\n');// clears the input buffer by reading and discarding all characters
+//scripted mode
+//plays games read from a file or pipe without prompts or board output
+//one game per line: mode size [3 roles if mode 3] then row col pairs for the human moves
+//a game that runs out of moves, or has moves left after it ended, counts as a failure
+//(running out of moves is allowed with --allow-incomplete)
+int runScript(FILE* in, unsigned int seed, int allowIncomplete);
+char* readAll(FILE* in, size_t* length);
+int readNumber(char** cursor, int* value);
+void skipLine(char** cursor);
+int restOfLineEmpty(char* cursor);
+int playScriptedGame(char** cursor, int gameNumber, unsigned int seed, int allowIncomplete);
+
+//snapshots
+//a small binary copy of the whole game so it can be resumed with --resume
+//packGame/unpackGame work on a plain buffer so a game can also be moved to another process
+int packGame(unsigned char* buffer, char** board, GameState* game);
+char** unpackGame(const unsigned char* buffer, int length, GameState* game);
+int saveGame(const char* path, char** board, GameState* game);
+char** loadGame(const char* path, GameState* game);
+int syncDirectory(const char* path);
+
+//training data export
+//self-play games between computer players, every position saved with its outcome and features
+//the file is a header followed by fixed-size chunks, so a reader can mmap it and jump to any chunk
+typedef struct {
+    unsigned char* data;// the whole chunk exactly as it is written to disk
+    int N;
+    int count;
+    PositionBatch batch;
+    BatchFeatures features;
+    unsigned char* toMove;// same column as batch.toMove, but writable
+    unsigned char* winner;
+    unsigned char* moveNumber;
+} ExportChunk;
+
+int runExport(const char* path, int games, int N, int numPlayers, unsigned int seed);
+int exportChunkBytes(int N);
+int createExportChunk(ExportChunk* chunk, int N, int numPlayers);
+int writeExportChunk(FILE* file, ExportChunk* chunk);
+int writeExportHeader(FILE* file, int N, int numPlayers, int numChunks, unsigned long long numPositions);
+
+//spectator feed
+//publishes the board to shared memory so viewer.c can watch the game (see spectator.h)
+void publishGame(SpectatorFeed* feed, char** board, GameState* game, int status, char winner);
+
+//random numbers
+//our own generator instead of rand() so its state can be saved in a snapshot
+unsigned int nextRandom(unsigned int* state);
+
+int quietMode = 0;//when set, the computer doesn't announce its moves
+
+int main(int argc, char* argv[]) {
+    // ./multiuser --script [file] [--seed N] [--allow-incomplete]  reads games from the file (or stdin) and prints one result per game
+    if (argc > 1 && strcmp(argv[1], "--script") == 0) {
+        const char* path = NULL;
+        unsigned int seed = SCRIPT_SEED;
+        int allowIncomplete = 0;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned int) strtoul(argv[++i], NULL, 10);
+            else if (strcmp(argv[i], "--allow-incomplete") == 0) allowIncomplete = 1;
+            else path = argv[i];
+        }
+        FILE* in = stdin;
+        if (path) {
+            in = fopen(path, "r");
+            if (!in) {
+                printf("Failed to open script file %s!\n", path);
+                return 1;
+            }
+        }
+        int status = runScript(in, seed, allowIncomplete);
+        if (in != stdin) fclose(in);
+        return status;
+    }
+    // ./multiuser --export file games [size] [players] [--seed N]  writes self-play training data
+    //the same seed gives exactly the same file, without --seed the clock picks one (it is printed)
+    if (argc > 1 && strcmp(argv[1], "--export") == 0) {
+        const char* values[4] = {NULL, NULL, NULL, NULL};// file, games, size, players
+        int numValues = 0;
+        unsigned int seed = (unsigned int) time(NULL);
+        int badArgs = 0;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned int) strtoul(argv[++i], NULL, 10);
+            else if (numValues < 4) values[numValues++] = argv[i];
+            else badArgs = 1;
+        }
+        int games = values[1] ? atoi(values[1]) : 0;
+        int N = values[2] ? atoi(values[2]) : MIN_SIZE;
+        int numPlayers = values[3] ? atoi(values[3]) : 2;
+        if (badArgs || numValues < 2 || games < 1 || N < MIN_SIZE || N > MAX_SIZE || numPlayers < 2 || numPlayers > 3) {
+            printf("Usage: %s --export file games [size 3-10] [players 2-3] [--seed N]\n", argv[0]);
+            return 1;
+        }
+        return runExport(values[0], games, N, numPlayers, seed);
     }
 
-    printf("Enter grid size (3-10): ");//choosing grid size
-    while (scanf("%d", &N) != 1 || N < MIN_SIZE || N > MAX_SIZE) {
-        printf("Invalid size. Enter a number between 3 and 10: ");
-        while(getchar() != '\n');// clears the input buffer by reading and discarding all characters
+    // ./multiuser [--save file]  saves the game to file (SAVE_FILE by default) after every move
+    // ./multiuser --resume [file]  continues that saved game and keeps saving to the same file
+    // ./multiuser [--feed name]  publishes the game for viewers under name (FEED_PREFIX + pid by default)
+    const char* savePath = SAVE_FILE;
+    char feedName[FEED_NAME_MAX];
+    snprintf(feedName, sizeof(feedName), FEED_PREFIX "%d", (int) getpid());
+    int resumed = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--resume") == 0) {
+            resumed = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-') savePath = argv[++i];
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--feed") == 0 && i + 1 < argc) {
+            snprintf(feedName, sizeof(feedName), "%s", argv[++i]);
+        }
     }
 
-    char** board = createBoard(N);// creating the board dynamically
-    if (!board) {
-        printf("Memory allocation failed!\n");
-        return 1;
+    GameState game;
+    char** board;
+    if (resumed) {
+        board = loadGame(savePath, &game);
+        if (!board) {
+            printf("No saved game to resume (or %s is damaged).\n", savePath);
+            return 1;
+        }
+    } else {
+        //choosing game mode
+        printf("Choose game mode:\n1. User vs User\n2. User vs Computer\n3. Multi-Player Mode (X, O, Z)\nEnter choice (1/2/3): ");
+        while (scanf("%d", &game.mode) != 1 || game.mode < 1 || game.mode > 3) {
+            printf("Invalid choice. Enter 1, 2, or 3: ");
+            while(getchar() != '\n');// clears the input buffer by reading and discarding all characters
+        }
+
+        printf("Enter grid size (3-10): ");//choosing grid size
+        while (scanf("%d", &game.N) != 1 || game.N < MIN_SIZE || game.N > MAX_SIZE) {
+            printf("Invalid size. Enter a number between 3 and 10: ");
+            while(getchar() != '\n');// clears the input buffer by reading and discarding all characters
+        }
+
+        board = createBoard(game.N);// creating the board dynamically
+        if (!board) {
+            printf("Memory allocation failed!\n");
+            return 1;
+        }
+
+        game.rngState = (unsigned int) time(NULL) | 1;//picks a random move each time we run the program
+
+        char players3[3] = {'X', 'O', 'Z'};//setting up players
+        for (int i = 0; i < 3; i++) game.playerRoles[i] = 1; // by default all human
+        game.numPlayers = (game.mode == 3) ? 3 : 2;// if the selected mode is 3 (multi-player), set number of players to 3,
+                                                   // otherwise set it to 2 (for user vs user or user vs computer modes)
+
+        //role selection in  multi-player mode
+        if (game.mode == 3) {
+            printf("\nChoose roles for 3 players (1 = Human, 2 = Computer):\n");
+            int hasHuman = 0;
+            for (int i = 0; i < 3; i++) {
+                printf("Player %c: ", players3[i]);
+                while (scanf("%d", &game.playerRoles[i]) != 1 || (game.playerRoles[i] != 1 && game.playerRoles[i] != 2)) {
+                    printf("Invalid input! Enter 1 for Human or 2 for Computer: ");
+                    while(getchar() != '\n');
+                }
+                if (game.playerRoles[i] == 1) hasHuman = 1;
+            }
+            // ensure at least one player is a user
+            if (!hasHuman) {
+                printf("At least one player must be human. Defaulting Player X to Human.\n");
+                game.playerRoles[0] = 1;
+            }
+            for (int i = 0; i < 3; i++) game.activePlayers[i] = players3[i];
+        } else if (game.mode == 2) {// ensure at least one human
+            game.activePlayers[0] = 'X';
+            game.activePlayers[1] = 'O';
+            game.playerRoles[0] = 1; // human
+            game.playerRoles[1] = 2; // computer
+        } else {// user vs user
+            game.activePlayers[0] = 'X';
+            game.activePlayers[1] = 'O';
+        }
+        game.activePlayers[2] = (game.mode == 3) ? 'Z' : ' ';
+        if (game.mode != 3) game.playerRoles[2] = 1;
+
+        game.currentIndex = 0;
+        game.moveCount = 0;
     }
 
+    int N = game.N;
     FILE* logFile = fopen("tic_tac_toe_log.txt", "a"); //opening log file in append mode
     if (!logFile) {
         printf("Failed to open log file!\n");
@@ -54,81 +250,68 @@ int main() {
         return 1;
     }
 
-    srand(time(NULL));//picks a random move each time we run the program
-
-    char players3[3] = {'X', 'O', 'Z'};//setting up players
-    int playerRoles[3] = {1, 1, 1}; // by default all human
-    int numPlayers = (mode == 3) ? 3 : 2;// if the selected mode is 3 (multi-player), set number of players to 3,
-                                      // otherwise set it to 2 (for user vs user or user vs computer modes)
-    char activePlayers[3];
-
-    //role selection in  multi-player mode
-    if (mode == 3) {
-        printf("\nChoose roles for 3 players (1 = Human, 2 = Computer):\n");
-        int hasHuman = 0;
-        for (int i = 0; i < 3; i++) {
-            printf("Player %c: ", players3[i]);
-            while (scanf("%d", &playerRoles[i]) != 1 || (playerRoles[i] != 1 && playerRoles[i] != 2)) {
-                printf("Invalid input! Enter 1 for Human or 2 for Computer: ");
-                while(getchar() != '\n');
-            }
-            if (playerRoles[i] == 1) hasHuman = 1;
-        }
-        // ensure at least one player is a user
-        if (!hasHuman) {
-            printf("At least one player must be human. Defaulting Player X to Human.\n");
-            playerRoles[0] = 1;
-        }
-        for (int i = 0; i < 3; i++) activePlayers[i] = players3[i];
-    } else if (mode == 2) {// ensure at least one human
-        activePlayers[0] = 'X';
-        activePlayers[1] = 'O';
-        playerRoles[0] = 1; // human
-        playerRoles[1] = 2; // computer
-    } else {// user vs user
-        activePlayers[0] = 'X';
-        activePlayers[1] = 'O';
-    }
-
-    char currentPlayer = activePlayers[0];
-    int currentIndex = 0;
+    char currentPlayer = game.activePlayers[game.currentIndex];
     int gameOver = 0;
 
-    printf("\nTic-Tac-Toe Game Starts!\n");
-    if (mode == 2) printf("(You = X, Computer = O)\n");
-    if (mode == 3) printf("(Players: X, O, Z)\n");
+    removeStaleFeeds();// feeds left behind by games that were killed
+    SpectatorFeed* feed = openFeed(feedName);// spectators are optional, the game runs fine without them
+    if (feed) unlinkFeedOnSignal(feedName);
+    if (feed) printf("Spectators can watch with: ./viewer %s\n", feedName);
+    else printf("Spectator feed %s unavailable (name already in use?), playing without it.\n", feedName);
+    publishGame(feed, board, &game, FEED_PLAYING, ' ');
 
-    displayBoard(board, N); //display an empty board
+    if (resumed) {
+        printf("\nResuming saved game after %d moves.\n", game.moveCount);
+        fprintf(logFile, "Game resumed after %d moves.\n", game.moveCount);
+    } else {
+        printf("\nTic-Tac-Toe Game Starts!\n");
+    }
+    if (game.mode == 2) printf("(You = X, Computer = O)\n");
+    if (game.mode == 3) printf("(Players: X, O, Z)\n");
+
+    displayBoard(board, N); //display the board (empty unless resumed)
 
     // main game loop
     while (!gameOver) {
         printf("\nPlayer %c's turn.\n", currentPlayer);
 
-        int role = playerRoles[currentIndex];
+        int row, col;
+        int role = game.playerRoles[game.currentIndex];
         if (role == 1) {  //human move
-            if (!playerMove(board, N, currentPlayer)) continue;
+            if (!playerMove(board, N, currentPlayer, &row, &col)) continue;
         } else {  //computer move
-            computerMove(board, N, currentPlayer, activePlayers, numPlayers);
+            computerMove(board, N, currentPlayer, game.activePlayers, game.numPlayers, &game.rngState, &row, &col);
         }
+        game.moveRows[game.moveCount] = (unsigned char) row;// remember the move for the snapshot
+        game.moveCols[game.moveCount] = (unsigned char) col;
+        game.moveCount++;
 
         logMove(logFile, board, N, currentPlayer);//saving each move to file
         displayBoard(board, N);//displaying updated board
 
-        char winner = checkWinner(board, N, activePlayers, numPlayers);// check winner
+        char winner = checkWinner(board, N, game.activePlayers, game.numPlayers);// check winner
         if (winner != ' ') {
             printf("\nPlayer %c wins!\n", winner);
             fprintf(logFile, "Player %c wins!\n", winner);
+            publishGame(feed, board, &game, FEED_WON, winner);
             gameOver = 1;
         } else if (isSuddenDraw(board, N)) {// check draw
             printf("\nIt's a draw!\n");
             fprintf(logFile, "Game ended in a draw.\n");
+            publishGame(feed, board, &game, FEED_DRAW, ' ');
             gameOver = 1;
         } else {//moves to next player's turn
-            currentIndex = (currentIndex + 1) % numPlayers;
-            currentPlayer = activePlayers[currentIndex];
+            game.currentIndex = (game.currentIndex + 1) % game.numPlayers;
+            currentPlayer = game.activePlayers[game.currentIndex];
+            publishGame(feed, board, &game, FEED_PLAYING, ' ');
+            if (game.moveCount % SAVE_EVERY == 0 && !saveGame(savePath, board, &game)) {
+                printf("Warning: could not save the game.\n");
+            }
         }
     }
 
+    remove(savePath);//finished games can't be resumed
+    closeFeed(feed, feedName);
     fclose(logFile);//closing file
     freeBoard(board, N);//free memory
     return 0;
@@ -177,25 +360,23 @@ void displayBoard(char** board, int N) {
 }
 
 //Player Moves
-int playerMove(char** board, int N, char player) {
-    int row, col;
+int playerMove(char** board, int N, char player, int* row, int* col) {
     printf("Enter row and column (1-%d): ", N);
-    if (scanf("%d %d", &row, &col) != 2 || row < 1 || row > N || col < 1 || col > N) {
+    if (scanf("%d %d", row, col) != 2 || *row < 1 || *row > N || *col < 1 || *col > N) {
         printf("Invalid input! Try again.\n");
         while(getchar() != '\n'); // clear wrong input
         return 0;
     }
-    row--; col--;// convert to 0-index
-    if (board[row][col] != ' ') {
+    (*row)--; (*col)--;// convert to 0-index
+    if (board[*row][*col] != ' ') {
         printf("Cell already occupied! Try again.\n");
         return 0;
     }
-    board[row][col] = player;// mark cell
+    board[*row][*col] = player;// mark cell
     return 1;
 }
 // Function that makes the computer decide its move
-void computerMove(char** board, int N, char player, char players[], int numPlayers) {
-    int row=-1, col=-1;
+void computerMove(char** board, int N, char player, char players[], int numPlayers, unsigned int* rng, int* row, int* col) {
 
     //Try to win
      //the computer first checks if it can win in this move
@@ -204,7 +385,8 @@ void computerMove(char** board, int N, char player, char players[], int numPlaye
         for (int j=0;j<N;j++) {
             if (willWin(board,N,player,i,j)) {//if placing here makes it win, take that move
                 board[i][j] = player;
-                printf("Computer placed %c at row %d, col %d (winning)\n", player, i+1, j+1);
+                *row = i; *col = j;
+                if (!quietMode) printf("Computer placed %c at row %d, col %d (winning)\n", player, i+1, j+1);
                 return;
             }
         }
@@ -220,7 +402,8 @@ void computerMove(char** board, int N, char player, char players[], int numPlaye
             for (int j=0;j<N;j++) {
                 if (willWin(board,N,opp,i,j)) {
                     board[i][j] = player;// block that spot
-                    printf("Computer placed %c at row %d, col %d (blocking %c)\n", player, i+1, j+1, opp);
+                    *row = i; *col = j;
+                    if (!quietMode) printf("Computer placed %c at row %d, col %d (blocking %c)\n", player, i+1, j+1, opp);
                     return;
                 }
             }
@@ -234,14 +417,15 @@ void computerMove(char** board, int N, char player, char players[], int numPlaye
     for (int i=0;i<N;i++)
         for (int j=0;j<N;j++)
             if (board[i][j]==' ') emptyCells++; //counting empty cells
-    int choice = rand()%emptyCells; //picking a random position number
+    int choice = nextRandom(rng)%emptyCells; //picking a random position number
     int count=0;
     for (int i=0;i<N;i++) {
         for (int j=0;j<N;j++) {
             if (board[i][j]==' ') {
                 if (count==choice) {
                     board[i][j] = player;//place symbol on that random empty cell
-                    printf("Computer placed %c at row %d, col %d\n", player, i+1, j+1);
+                    *row = i; *col = j;
+                    if (!quietMode) printf("Computer placed %c at row %d, col %d\n", player, i+1, j+1);
                     return;
                 }
                 count++;
@@ -313,3 +497,482 @@ void logMove(FILE* file, char** board, int N, char player) {
     }
     fprintf(file,"\n");
 }
+
+//Scripted Mode
+//reads every game from the stream and plays them one after another
+//results go to stdout as "Game <n>: ..." lines so recorded games can be compared
+//every game starts from the same seed, so each line replays the same way on its own
+int runScript(FILE* in, unsigned int seed, int allowIncomplete) {
+    size_t length;
+    char* text = readAll(in, &length);
+    if (!text) {
+        printf("Failed to read script!\n");
+        return 1;
+    }
+
+    quietMode = 1;//no prompts or computer messages while replaying
+    if (seed == 0) seed = 1;// xorshift gets stuck at 0
+
+    char* cursor = text;
+    int gameNumber = 0;
+    int failed = 0;
+    while (*cursor) {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') cursor++;
+        if (*cursor == '\n') { cursor++; continue; }// blank line
+        if (*cursor == '#') { skipLine(&cursor); continue; }// comment line
+        if (*cursor == '\0') break;
+        gameNumber++;
+        if (!playScriptedGame(&cursor, gameNumber, seed, allowIncomplete)) failed = 1;
+        skipLine(&cursor);// after an error the rest of the line is skipped
+    }
+
+    quietMode = 0;
+    free(text);
+    return failed;
+}
+
+//loads the whole stream into one buffer so parsing never waits on input
+char* readAll(FILE* in, size_t* length) {
+    size_t capacity = 1 << 16, used = 0;
+    char* text = (char*) malloc(capacity);
+    if (!text) return NULL;
+    size_t got;
+    while ((got = fread(text + used, 1, capacity - used - 1, in)) > 0) {
+        used += got;
+        if (used + 1 == capacity) {// buffer full, double it
+            char* bigger = (char*) realloc(text, capacity * 2);
+            if (!bigger) {
+                free(text);
+                return NULL;
+            }
+            text = bigger;
+            capacity *= 2;
+        }
+    }
+    text[used] = '\0';
+    *length = used;
+    return text;
+}
+
+//reads the next non-negative number on the current line
+//returns 0 at the end of the line or if the next token isn't a number
+//very long numbers are read completely and clamped, so they still fail the range checks
+int readNumber(char** cursor, int* value) {
+    char* p = *cursor;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == ',') p++;
+    if (*p < '0' || *p > '9') {
+        *cursor = p;
+        return 0;
+    }
+    int n = 0;
+    while (*p >= '0' && *p <= '9') {
+        if (n < 1000000) n = n * 10 + (*p - '0');
+        p++;
+    }
+    *cursor = p;
+    *value = n;
+    return 1;
+}
+
+//true if only spaces or a comment are left before the end of the line
+int restOfLineEmpty(char* cursor) {
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == ',') cursor++;
+    return *cursor == '\0' || *cursor == '\n' || *cursor == '#';
+}
+
+void skipLine(char** cursor) {
+    char* p = *cursor;
+    while (*p && *p != '\n') p++;
+    if (*p == '\n') p++;
+    *cursor = p;
+}
+
+//plays one game from the current line and prints its result
+//returns 0 if the line was malformed or contained an illegal move
+int playScriptedGame(char** cursor, int gameNumber, unsigned int seed, int allowIncomplete) {
+    int mode, N;
+    if (!readNumber(cursor, &mode) || mode < 1 || mode > 3) {
+        printf("Game %d: error: invalid mode\n", gameNumber);
+        return 0;
+    }
+    if (!readNumber(cursor, &N) || N < MIN_SIZE || N > MAX_SIZE) {
+        printf("Game %d: error: invalid size\n", gameNumber);
+        return 0;
+    }
+
+    //same player setup as the interactive mode
+    char activePlayers[3] = {'X', 'O', 'Z'};
+    int playerRoles[3] = {1, 1, 1};
+    int numPlayers = (mode == 3) ? 3 : 2;
+    if (mode == 3) {
+        int hasHuman = 0;
+        for (int i = 0; i < 3; i++) {
+            if (!readNumber(cursor, &playerRoles[i]) || (playerRoles[i] != 1 && playerRoles[i] != 2)) {
+                printf("Game %d: error: invalid role for player %c\n", gameNumber, activePlayers[i]);
+                return 0;
+            }
+            if (playerRoles[i] == 1) hasHuman = 1;
+        }
+        if (!hasHuman) playerRoles[0] = 1;
+    } else if (mode == 2) {
+        playerRoles[1] = 2;// O is the computer
+    }
+
+    char** board = createBoard(N);
+    if (!board) {
+        printf("Game %d: error: memory allocation failed\n", gameNumber);
+        return 0;
+    }
+
+    int currentIndex = 0;
+    int moves = 0;
+    int ok = 1;
+    unsigned int rng = seed;
+    while (1) {
+        char currentPlayer = activePlayers[currentIndex];
+        if (playerRoles[currentIndex] == 1) {// human move comes from the script
+            int row, col;
+            if (!readNumber(cursor, &row)) {
+                printf("Game %d: incomplete after %d moves\n", gameNumber, moves);
+                if (!allowIncomplete) ok = 0;
+                break;
+            }
+            if (!readNumber(cursor, &col) || row < 1 || row > N || col < 1 || col > N) {
+                printf("Game %d: error: invalid move %d by player %c\n", gameNumber, moves + 1, currentPlayer);
+                ok = 0;
+                break;
+            }
+            if (board[row-1][col-1] != ' ') {
+                printf("Game %d: error: move %d by player %c is on an occupied cell\n", gameNumber, moves + 1, currentPlayer);
+                ok = 0;
+                break;
+            }
+            board[row-1][col-1] = currentPlayer;
+        } else {
+            int row, col;
+            computerMove(board, N, currentPlayer, activePlayers, numPlayers, &rng, &row, &col);
+        }
+        moves++;
+
+        char winner = checkWinner(board, N, activePlayers, numPlayers);
+        int over = (winner != ' ' || isSuddenDraw(board, N));
+        if (over && winner != ' ') printf("Game %d: Player %c wins in %d moves\n", gameNumber, winner, moves);
+        else if (over) printf("Game %d: draw in %d moves\n", gameNumber, moves);
+        if (over && !restOfLineEmpty(*cursor)) {// the recording doesn't match how the game went
+            printf("Game %d: error: moves left over after the game ended\n", gameNumber);
+            ok = 0;
+        }
+        if (over) break;
+        currentIndex = (currentIndex + 1) % numPlayers;
+    }
+
+    freeBoard(board, N);
+    return ok;
+}
+
+//Snapshots
+//layout (all single bytes unless noted):
+//  "TTTS", version, N, mode, numPlayers, activePlayers[3], playerRoles[3],
+//  currentIndex, moveCount, rngState (4 bytes, little-endian), 4 spare bytes,
+//  board (N*N cells, row by row), then row/col for every move
+int packGame(unsigned char* buffer, char** board, GameState* game) {
+    int n = 0;
+    buffer[n++] = 'T'; buffer[n++] = 'T'; buffer[n++] = 'T'; buffer[n++] = 'S';
+    buffer[n++] = SNAPSHOT_VERSION;
+    buffer[n++] = (unsigned char) game->N;
+    buffer[n++] = (unsigned char) game->mode;
+    buffer[n++] = (unsigned char) game->numPlayers;
+    for (int i = 0; i < 3; i++) buffer[n++] = (unsigned char) game->activePlayers[i];
+    for (int i = 0; i < 3; i++) buffer[n++] = (unsigned char) game->playerRoles[i];
+    buffer[n++] = (unsigned char) game->currentIndex;
+    buffer[n++] = (unsigned char) game->moveCount;
+    for (int i = 0; i < 4; i++) buffer[n++] = (unsigned char) (game->rngState >> (8 * i));
+    for (int i = 0; i < 4; i++) buffer[n++] = 0;
+    for (int i = 0; i < game->N; i++)
+        for (int j = 0; j < game->N; j++)
+            buffer[n++] = (unsigned char) board[i][j];
+    for (int m = 0; m < game->moveCount; m++) {
+        buffer[n++] = game->moveRows[m];
+        buffer[n++] = game->moveCols[m];
+    }
+    return n;// number of bytes used
+}
+
+//checks every field before trusting it, returns NULL for anything malformed
+//the board and history must describe a game that is still going, with the moves in turn order
+char** unpackGame(const unsigned char* buffer, int length, GameState* game) {
+    const char symbols[3] = {'X', 'O', 'Z'};
+    if (length < 24 || buffer[0] != 'T' || buffer[1] != 'T' || buffer[2] != 'T' || buffer[3] != 'S') return NULL;
+    if (buffer[4] != SNAPSHOT_VERSION) return NULL;
+    game->N = buffer[5];
+    game->mode = buffer[6];
+    game->numPlayers = buffer[7];
+    if (game->N < MIN_SIZE || game->N > MAX_SIZE || game->mode < 1 || game->mode > 3) return NULL;
+    if (game->numPlayers != ((game->mode == 3) ? 3 : 2)) return NULL;
+    int hasHuman = 0;
+    for (int i = 0; i < 3; i++) {
+        game->activePlayers[i] = (char) buffer[8 + i];
+        game->playerRoles[i] = buffer[11 + i];
+        if (game->playerRoles[i] != 1 && game->playerRoles[i] != 2) return NULL;
+        if (i < game->numPlayers && game->activePlayers[i] != symbols[i]) return NULL;// X, O (and Z) in order
+        if (i < game->numPlayers && game->playerRoles[i] == 1) hasHuman = 1;
+    }
+    if (!hasHuman) return NULL;
+    game->currentIndex = buffer[14];
+    game->moveCount = buffer[15];
+    game->rngState = 0;
+    for (int i = 0; i < 4; i++) game->rngState |= (unsigned int) buffer[16 + i] << (8 * i);
+    int N = game->N;
+    if (game->moveCount >= N * N || game->rngState == 0) return NULL;
+    if (game->currentIndex != game->moveCount % game->numPlayers) return NULL;
+    if (length != 24 + N * N + 2 * game->moveCount) return NULL;
+
+    char** board = createBoard(N);
+    if (!board) return NULL;
+    int n = 24;
+    int filled = 0;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            char cell = (char) buffer[n++];
+            int known = (cell == ' ');
+            for (int p = 0; p < game->numPlayers; p++) if (cell == game->activePlayers[p]) known = 1;
+            if (!known) {
+                freeBoard(board, N);
+                return NULL;
+            }
+            if (cell != ' ') filled++;
+            board[i][j] = cell;
+        }
+    }
+    int valid = (filled == game->moveCount);// history must match the board
+    unsigned char used[MAX_SIZE * MAX_SIZE] = {0};
+    for (int m = 0; m < game->moveCount && valid; m++) {
+        int row = buffer[n++];
+        int col = buffer[n++];
+        game->moveRows[m] = (unsigned char) row;
+        game->moveCols[m] = (unsigned char) col;
+        //each cell once, holding the mark of the player whose turn it was
+        if (row >= N || col >= N || used[row * N + col] || board[row][col] != game->activePlayers[m % game->numPlayers]) valid = 0;
+        else used[row * N + col] = 1;
+    }
+    if (valid && (checkWinner(board, N, game->activePlayers, game->numPlayers) != ' ' || isSuddenDraw(board, N))) valid = 0;// already over
+    if (!valid) {
+        freeBoard(board, N);
+        return NULL;
+    }
+    return board;
+}
+
+//writes to a temporary file first and renames it over the old snapshot,
+//so a crash in the middle never leaves a half-written save behind
+//syncing the directory afterwards makes sure the rename itself survives a power cut
+int saveGame(const char* path, char** board, GameState* game) {
+    unsigned char buffer[MAX_SNAPSHOT];
+    int length = packGame(buffer, board, game);
+
+    char tempPath[4096];
+    if (snprintf(tempPath, sizeof(tempPath), "%s.tmp", path) >= (int) sizeof(tempPath)) return 0;
+    FILE* file = fopen(tempPath, "wb");
+    if (!file) return 0;
+    int ok = (fwrite(buffer, 1, length, file) == (size_t) length);
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok || rename(tempPath, path) != 0) {
+        remove(tempPath);
+        return 0;
+    }
+    return syncDirectory(path);
+}
+
+//fsyncs the directory that holds path ("." if it has no directory part)
+int syncDirectory(const char* path) {
+    char dir[4096];
+    if (snprintf(dir, sizeof(dir), "%s", path) >= (int) sizeof(dir)) return 0;
+    char* slash = strrchr(dir, '/');
+    if (!slash) strcpy(dir, ".");
+    else if (slash == dir) dir[1] = '\0';// file in the root directory
+    else *slash = '\0';
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return 0;
+    int ok = (fsync(fd) == 0);
+    close(fd);
+    return ok;
+}
+
+char** loadGame(const char* path, GameState* game) {
+    unsigned char buffer[MAX_SNAPSHOT + 1];
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    int length = (int) fread(buffer, 1, sizeof(buffer), file);// reading one extra byte catches oversized files
+    fclose(file);
+    return unpackGame(buffer, length, game);
+}
+
+//Training Data Export
+//file header (EXPORT_HEADER bytes, little-endian):
+//  "TTTD", version (4 bytes), N (4), chunk capacity (4), number of chunks (4), players (4), number of positions (8)
+//each chunk (exportChunkBytes(N) bytes): position count (4 bytes) padded to EXPORT_HEADER,
+//then one column of EXPORT_CHUNK entries per field:
+//  N*N cell columns (0 empty, 1 X, 2 O, 3 Z), toMove (1-3), winner (0 = draw, 1-3), moveNumber,
+//  winLines, blockLines, openLines, oppOpenLines (see evaluate.h), value (4-byte IEEE float, little-endian)
+//entries past the chunk's count are zero
+int runExport(const char* path, int games, int N, int numPlayers, unsigned int seed) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("Failed to open %s!\n", path);
+        return 1;
+    }
+    ExportChunk chunk;
+    char** board = createBoard(N);
+    if (!board || !createExportChunk(&chunk, N, numPlayers)) {
+        printf("Memory allocation failed!\n");
+        if (board) freeBoard(board, N);
+        fclose(file);
+        return 1;
+    }
+
+    quietMode = 1;
+    unsigned int rng = seed ? seed : 1;// xorshift gets stuck at 0
+    char players[3] = {'X', 'O', 'Z'};
+    //positions of the current game are kept until we know who won
+    unsigned char gameCells[MAX_SIZE * MAX_SIZE][MAX_SIZE * MAX_SIZE];
+    unsigned char gameToMove[MAX_SIZE * MAX_SIZE];
+    int numChunks = 0;
+    unsigned long long numPositions = 0;
+    int ok = 1;
+
+    ok = writeExportHeader(file, N, numPlayers, 0, 0);// filled in properly once we know the totals
+    for (int g = 0; g < games && ok; g++) {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++) board[i][j] = ' ';
+
+        int moves = 0, currentIndex = 0;
+        unsigned char winner = 0;
+        while (1) {
+            for (int i = 0; i < N; i++)// save the position before the move
+                for (int j = 0; j < N; j++) {
+                    char cell = board[i][j];
+                    gameCells[moves][i * N + j] = (cell == 'X') ? 1 : (cell == 'O') ? 2 : (cell == 'Z') ? 3 : 0;
+                }
+            gameToMove[moves] = (unsigned char) (currentIndex + 1);
+            moves++;
+
+            int row, col;
+            computerMove(board, N, players[currentIndex], players, numPlayers, &rng, &row, &col);
+            if (checkWin(board, N, players[currentIndex])) {
+                winner = (unsigned char) (currentIndex + 1);
+                break;
+            }
+            if (isSuddenDraw(board, N)) break;
+            currentIndex = (currentIndex + 1) % numPlayers;
+        }
+
+        for (int m = 0; m < moves && ok; m++) {// copy the game into the chunk, one column per cell
+            int p = chunk.count;
+            for (int c = 0; c < N * N; c++) chunk.data[EXPORT_HEADER + (long) c * EXPORT_CHUNK + p] = gameCells[m][c];
+            chunk.toMove[p] = gameToMove[m];
+            chunk.winner[p] = winner;
+            chunk.moveNumber[p] = (unsigned char) m;
+            chunk.count++;
+            if (chunk.count == EXPORT_CHUNK) {
+                ok = writeExportChunk(file, &chunk);
+                numChunks++;
+            }
+        }
+        numPositions += moves;
+    }
+    if (ok && chunk.count > 0) {
+        ok = writeExportChunk(file, &chunk);
+        numChunks++;
+    }
+    if (ok) ok = (fseek(file, 0, SEEK_SET) == 0) && writeExportHeader(file, N, numPlayers, numChunks, numPositions);
+    if (fclose(file) != 0) ok = 0;
+    quietMode = 0;
+    free(chunk.data);
+    freeBoard(board, N);
+
+    if (!ok) {
+        printf("Failed to write %s!\n", path);
+        return 1;
+    }
+    printf("Exported %llu positions from %d games in %d chunks (seed %u).\n", numPositions, games, numChunks, seed);
+    return 0;
+}
+
+int exportChunkBytes(int N) {
+    return EXPORT_HEADER + EXPORT_CHUNK * (N * N + 7) + EXPORT_CHUNK * (int) sizeof(float);
+}
+
+//one zeroed buffer for a whole chunk, with batch and features pointing at its columns
+int createExportChunk(ExportChunk* chunk, int N, int numPlayers) {
+    chunk->data = (unsigned char*) calloc(1, exportChunkBytes(N));
+    if (!chunk->data) return 0;
+    chunk->N = N;
+    chunk->count = 0;
+    unsigned char* column = chunk->data + EXPORT_HEADER;
+    chunk->batch.N = N;
+    chunk->batch.numPlayers = numPlayers;
+    chunk->batch.stride = EXPORT_CHUNK;
+    chunk->batch.cells = column;
+    column += (long) N * N * EXPORT_CHUNK;
+    chunk->toMove = column;
+    chunk->batch.toMove = column; column += EXPORT_CHUNK;
+    chunk->winner = column; column += EXPORT_CHUNK;
+    chunk->moveNumber = column; column += EXPORT_CHUNK;
+    chunk->features.winLines = column; column += EXPORT_CHUNK;
+    chunk->features.blockLines = column; column += EXPORT_CHUNK;
+    chunk->features.openLines = column; column += EXPORT_CHUNK;
+    chunk->features.oppOpenLines = column; column += EXPORT_CHUNK;
+    chunk->features.value = (float*) column;
+    return 1;
+}
+
+//fills in the feature columns, writes the chunk and clears it for the next positions
+int writeExportChunk(FILE* file, ExportChunk* chunk) {
+    chunk->batch.count = chunk->count;
+    evaluateBatch(&chunk->batch, &chunk->features);
+    for (int p = 0; p < chunk->count; p++) {// store the values little-endian whatever this machine uses
+        unsigned int bits;
+        memcpy(&bits, &chunk->features.value[p], sizeof(bits));
+        unsigned char* out = (unsigned char*) &chunk->features.value[p];
+        for (int i = 0; i < 4; i++) out[i] = (unsigned char) (bits >> (8 * i));
+    }
+    for (int i = 0; i < 4; i++) chunk->data[i] = (unsigned char) (chunk->count >> (8 * i));
+    int bytes = exportChunkBytes(chunk->N);
+    int ok = (fwrite(chunk->data, 1, bytes, file) == (size_t) bytes);
+    memset(chunk->data, 0, bytes);
+    chunk->count = 0;
+    return ok;
+}
+
+int writeExportHeader(FILE* file, int N, int numPlayers, int numChunks, unsigned long long numPositions) {
+    unsigned char header[EXPORT_HEADER] = {'T', 'T', 'T', 'D'};
+    unsigned int fields[5] = {EXPORT_VERSION, (unsigned int) N, EXPORT_CHUNK, (unsigned int) numChunks, (unsigned int) numPlayers};
+    for (int f = 0; f < 5; f++)
+        for (int i = 0; i < 4; i++) header[4 + 4 * f + i] = (unsigned char) (fields[f] >> (8 * i));
+    for (int i = 0; i < 8; i++) header[24 + i] = (unsigned char) (numPositions >> (8 * i));
+    return fwrite(header, 1, EXPORT_HEADER, file) == EXPORT_HEADER;
+}
+
+//Spectator Feed
+//passes the current game to publishFeed (spectator.c), working out the last move from the history
+void publishGame(SpectatorFeed* feed, char** board, GameState* game, int status, char winner) {
+    int lastRow = -1, lastCol = -1;
+    if (game->moveCount > 0) {
+        lastRow = game->moveRows[game->moveCount - 1];
+        lastCol = game->moveCols[game->moveCount - 1];
+    }
+    publishFeed(feed, board, game->N, game->activePlayers[game->currentIndex],
+                game->moveCount, lastRow, lastCol, status, winner);
+}
+
+//Random Numbers
+//xorshift32, small and fast, and the whole state fits in one number
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200809L // for shm_open, kill, sigaction and nanosleep
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "spectator.h"
+
+//Writer
+//creates a new shared memory segment, returns NULL if that isn't possible or the name is taken
+SpectatorFeed* openFeed(const char* name) {
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return NULL;
+    if (ftruncate(fd, sizeof(SpectatorFeed)) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    void* memory = mmap(NULL, sizeof(SpectatorFeed), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);// the mapping stays valid after closing
+    if (memory == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+    SpectatorFeed* feed = (SpectatorFeed*) memory;// new segments start zeroed, so seq is 0
+    atomic_store_explicit(&feed->writerPid, (int) getpid(), memory_order_release);
+    return feed;
+}
+
+//seqlock write: make seq odd, update the fields, make seq even again
+//it never waits, readers are the ones who retry
+void publishFeed(SpectatorFeed* feed, char** board, int N, char currentPlayer,
+                 int moveCount, int lastRow, int lastCol, int status, char winner) {
+    if (!feed) return;
+    unsigned int seq = atomic_load_explicit(&feed->seq, memory_order_relaxed);
+    atomic_store_explicit(&feed->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);// the odd seq must be visible before any field changes
+
+    feed->N = N;
+    for (int i = 0; i < N; i++) memcpy(feed->board[i], board[i], N);
+    feed->currentPlayer = currentPlayer;
+    feed->moveCount = moveCount;
+    feed->lastRow = lastRow;
+    feed->lastCol = lastCol;
+    feed->lastPlayer = (lastRow >= 0) ? board[lastRow][lastCol] : ' ';
+    feed->status = status;
+    feed->winner = winner;
+
+    atomic_store_explicit(&feed->seq, seq + 2, memory_order_release);
+}
+
+//viewers that are already attached keep their mapping and still see the final board
+void closeFeed(SpectatorFeed* feed, const char* name) {
+    if (!feed) return;
+    munmap(feed, sizeof(SpectatorFeed));
+    shm_unlink(name);
+}
+
+char signalFeedName[FEED_NAME_MAX];// the feed to remove if the game is interrupted
+
+void unlinkFeedAndExit(int sig) {
+    shm_unlink(signalFeedName);
+    signal(sig, SIG_DFL);// then die the way the signal would have made us
+    raise(sig);
+}
+
+void unlinkFeedOnSignal(const char* name) {
+    snprintf(signalFeedName, sizeof(signalFeedName), "%s", name);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = unlinkFeedAndExit;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+}
+
+//POSIX has no way to list shared memory, so this looks in /dev/shm where Linux keeps it
+void removeStaleFeeds(void) {
+    DIR* dir = opendir("/dev/shm");
+    if (!dir) return;
+    const char* prefix = FEED_PREFIX + 1;// directory entries have no leading '/'
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, prefix, strlen(prefix)) != 0) continue;
+        char name[FEED_NAME_MAX];
+        if (snprintf(name, sizeof(name), "/%s", entry->d_name) >= (int) sizeof(name)) continue;
+        const SpectatorFeed* feed = attachFeed(name);
+        if (!feed) continue;// not sized yet, its game may still be starting
+        int pid = atomic_load_explicit((atomic_int*) &feed->writerPid, memory_order_acquire);
+        if (pid != 0 && !feedWriterAlive(feed)) shm_unlink(name);// pid 0: openFeed hasn't finished
+        detachFeed(feed);
+    }
+    closedir(dir);
+}
+
+//Reader
+const SpectatorFeed* attachFeed(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(SpectatorFeed)) {// not sized yet, reading it would crash
+        close(fd);
+        return NULL;
+    }
+    void* memory = mmap(NULL, sizeof(SpectatorFeed), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) return NULL;
+    return (const SpectatorFeed*) memory;
+}
+
+void detachFeed(const SpectatorFeed* feed) {
+    munmap((void*) feed, sizeof(SpectatorFeed));
+}
+
+//seqlock read: copy everything, then make sure the game didn't change it meanwhile
+//an odd seq means the game is mid-update, so wait a little instead of spinning;
+//after FEED_RETRIES tries give up, a game that died mid-update leaves seq odd forever
+unsigned int readFeed(const SpectatorFeed* feed, SpectatorFeed* copy) {
+    struct timespec pause = {0, 1000000L};
+    size_t skip = offsetof(SpectatorFeed, N);// everything after seq and writerPid
+    for (int tries = 0; tries < FEED_RETRIES; tries++) {
+        unsigned int before = atomic_load_explicit((atomic_uint*) &feed->seq, memory_order_acquire);
+        if (before & 1) {
+            nanosleep(&pause, NULL);
+            continue;
+        }
+        memcpy((char*) copy + skip, (const char*) feed + skip, sizeof(SpectatorFeed) - skip);
+        atomic_thread_fence(memory_order_acquire);// finish copying before checking seq again
+        unsigned int after = atomic_load_explicit((atomic_uint*) &feed->seq, memory_order_relaxed);
+        if (before == after) return before;
+    }
+    return 0;
+}
+
+//checks whether the game process still exists (EPERM means it does, it just isn't ours)
+int feedWriterAlive(const SpectatorFeed* feed) {
+    int pid = atomic_load_explicit((atomic_int*) &feed->writerPid, memory_order_acquire);
+    if (pid <= 0) return 0;
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
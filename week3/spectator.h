@@ -0,0 +1,57 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <stdatomic.h>
+
+//shared memory feed that lets other programs watch a running game
+//multiuser.c writes it after every move, viewer.c only reads it
+//every game gets its own feed, named FEED_PREFIX followed by the game's pid unless --feed is given
+//on older glibc, programs using spectator.c need -lrt for shm_open
+
+#define FEED_PREFIX "/tic_tac_toe_"
+#define FEED_NAME_MAX 64
+#define FEED_MAX_SIZE 10
+#define FEED_RETRIES 100 //readFeed gives up after this many tries (about 1 ms apart while the game is writing)
+
+//game status values
+#define FEED_PLAYING 0
+#define FEED_WON 1
+#define FEED_DRAW 2
+
+//seqlock: the writer makes seq odd while it is changing the fields and even again when done
+//readers copy the fields and retry if seq was odd or changed while they were copying,
+//so the game never has to wait for a viewer
+typedef struct {
+    atomic_uint seq;
+    atomic_int writerPid;// the game process, set once before the first update
+    int N;
+    char board[FEED_MAX_SIZE][FEED_MAX_SIZE];
+    char currentPlayer;// whose turn it is now
+    char lastPlayer;// who made the last move (' ' before the first move)
+    int lastRow, lastCol;// 0-indexed, -1 before the first move
+    int moveCount;
+    int status;// FEED_PLAYING, FEED_WON or FEED_DRAW
+    char winner;
+} SpectatorFeed;
+
+//writer side (the game)
+//openFeed refuses a name that is already in use, so two games never share a seqlock
+SpectatorFeed* openFeed(const char* name);
+void publishFeed(SpectatorFeed* feed, char** board, int N, char currentPlayer,
+                 int moveCount, int lastRow, int lastCol, int status, char winner);
+void closeFeed(SpectatorFeed* feed, const char* name);
+//a killed game can't unlink its feed, so the writer cleans up after itself and others:
+//unlinkFeedOnSignal removes the feed if the game gets SIGINT, SIGTERM or SIGHUP,
+//removeStaleFeeds deletes every FEED_PREFIX feed whose game is gone (SIGKILL, crashes)
+void unlinkFeedOnSignal(const char* name);
+void removeStaleFeeds(void);
+
+//reader side (viewers)
+//attachFeed returns NULL if there is no such feed or the game hasn't finished creating it
+const SpectatorFeed* attachFeed(const char* name);
+void detachFeed(const SpectatorFeed* feed);
+//returns the even sequence number of the copy, or 0 if nothing usable could be read
+unsigned int readFeed(const SpectatorFeed* feed, SpectatorFeed* copy);
+int feedWriterAlive(const SpectatorFeed* feed);
+
+#endif
@@ -0,0 +1,79 @@
+#define _POSIX_C_SOURCE 200809L // for nanosleep
+#include <stdio.h>
+#include <time.h>
+#include "spectator.h"
+
+//spectator for a game running in multiuser.c
+//attaches to the game's shared memory feed read-only and redraws the board after every move
+//any number of viewers can watch at once without slowing the game down
+//usage: ./viewer feed-name  (the game prints its feed name when it starts)
+
+#define POLL_MS 50 //how often to look for a new move
+
+void displayFeedBoard(const SpectatorFeed* copy);
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s feed-name\n", argv[0]);
+        return 1;
+    }
+    const SpectatorFeed* feed = attachFeed(argv[1]);
+    if (!feed) {
+        printf("No game is being played under %s.\n", argv[1]);
+        return 1;
+    }
+
+    struct timespec pause = {0, POLL_MS * 1000000L};
+    unsigned int lastSeen = 0;
+    int status = 0;
+    SpectatorFeed copy;
+    while (1) {
+        unsigned int seq = readFeed(feed, &copy);
+        if (seq != 0 && seq != lastSeen) {// something changed since the last redraw
+            lastSeen = seq;
+            if (copy.lastPlayer != ' ')
+                printf("\nPlayer %c played row %d, col %d (move %d)\n", copy.lastPlayer, copy.lastRow + 1, copy.lastCol + 1, copy.moveCount);
+            displayFeedBoard(&copy);
+            if (copy.status == FEED_WON) {
+                printf("Player %c wins!\n", copy.winner);
+                break;
+            }
+            if (copy.status == FEED_DRAW) {
+                printf("It's a draw!\n");
+                break;
+            }
+            printf("Player %c's turn.\n", copy.currentPlayer);
+            fflush(stdout);
+        } else if (!feedWriterAlive(feed)) {// nothing new and nobody left to write it
+            printf("The game stopped before it finished.\n");
+            status = 1;
+            break;
+        }
+        nanosleep(&pause, NULL);
+    }
+
+    detachFeed(feed);
+    return status;
+}
+
+//same layout as displayBoard in multiuser.c
+void displayFeedBoard(const SpectatorFeed* copy) {
+    int N = copy->N;
+    if (N < 1 || N > FEED_MAX_SIZE) return;// nothing published yet
+    printf("\n");
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            printf(" %c ", copy->board[i][j]);
+            if (j != N-1) printf("|");
+        }
+        printf("\n");
+        if (i != N-1) {
+            for (int k = 0; k < N; k++) {
+                printf("---");
+                if (k != N-1) printf("+");
+            }
+            printf("\n");
+        }
+    }
+    printf("\n");
+}